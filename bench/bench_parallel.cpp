@@ -0,0 +1,95 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "expression.hpp"
+#include "parallel.hpp"
+
+// Масштабирование parallelDerivative / parallelSubstitute по числу потоков
+// на больших сгенерированных выражениях. Ускорение считается относительно
+// последовательных derivative / substitute, которые строят то же дерево
+// тем же способом, так что разница - только от разбиения на задачи.
+
+using Expr = Expression<double>;
+using Type = Expr::Type;
+
+static const int REPEATS = 3;
+
+static Expr node(Type type, Expr left, Expr right) {
+    return Expr(type, std::unique_ptr<Expr>(new Expr(std::move(left))),
+                std::unique_ptr<Expr>(new Expr(std::move(right))));
+}
+
+static Expr node(Type type, Expr arg) {
+    return Expr(type, std::unique_ptr<Expr>(new Expr(std::move(arg))), nullptr);
+}
+
+// sin(i*x) * (x^2 + i*y) * exp(x/i)
+static Expr term(int i) {
+    Expr c(static_cast<double>(i));
+    Expr a = node(Type::Sin, node(Type::Multiply, c, Expr("x")));
+    Expr b = node(Type::Add, node(Type::Power, Expr("x"), Expr(2.0)), node(Type::Multiply, c, Expr("y")));
+    Expr e = node(Type::Exp, node(Type::Divide, Expr("x"), c));
+    return node(Type::Multiply, node(Type::Multiply, std::move(a), std::move(b)), std::move(e));
+}
+
+// Сумма terms слагаемых (левая цепочка, как у парсера)
+static Expr sum(int first, int terms) {
+    Expr result = term(first);
+    for (int i = first + 1; i < first + terms; ++i)
+        result = node(i % 3 == 0 ? Type::Subtract : Type::Add, std::move(result), term(i));
+    return result;
+}
+
+// Произведение factors сумм по terms слагаемых
+static Expr product(int factors, int terms) {
+    Expr result = sum(1, terms);
+    for (int i = 1; i < factors; ++i)
+        result = node(Type::Multiply, std::move(result), sum(i * terms + 1, terms));
+    return result;
+}
+
+template<typename F>
+static double measure(F&& body) {
+    body();
+    double best = 0.0;
+    for (int r = 0; r < REPEATS; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (r == 0 || ms < best)
+            best = ms;
+    }
+    return best;
+}
+
+static void scale(const std::string& name, const Expr& expr, std::size_t maxThreads) {
+    std::cout << name << " (ускорение относительно последовательной версии)" << std::endl;
+    double sequentialDerivative = measure([&] { Expr d = expr.derivative("x"); });
+    double sequentialSubstitute = measure([&] { Expr s = expr.substitute("x", 2.0); });
+    std::cout << "  последовательно: derivative " << sequentialDerivative
+              << " мс, substitute " << sequentialSubstitute << " мс" << std::endl;
+
+    for (std::size_t threads = 1; threads <= maxThreads; ++threads) {
+        ThreadPool pool(threads);
+        double derivative = measure([&] { Expr d = parallelDerivative(expr, "x", pool); });
+        double substitute = measure([&] { Expr s = parallelSubstitute(expr, "x", 2.0, pool); });
+        std::cout << "  потоков " << threads
+                  << ": derivative " << derivative << " мс (x" << sequentialDerivative / derivative << ")"
+                  << ", substitute " << substitute << " мс (x" << sequentialSubstitute / substitute << ")"
+                  << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t maxThreads = argc > 1 ? std::stoul(argv[1]) : std::thread::hardware_concurrency();
+    if (maxThreads == 0)
+        maxThreads = 1;
+
+    scale("Сумма 2000 слагаемых", sum(1, 2000), maxThreads);
+    scale("Произведение 4 сумм по 500 слагаемых", product(4, 500), maxThreads);
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include "expression.hpp"
+#include "parser.hpp"
+#include "static_expression.hpp"
+
+// Сравнение статических выражений (static_expression.hpp) с Expression<T>
+// на одной и той же формуле и её производной по x.
+
+static const int ITERATIONS = 200000;
+static const char* FORMULA = "sin(x)*exp(y) + x^3/(1 + y*y) - cos(x*y)";
+
+template<typename F>
+static void run(const std::string& name, F&& body) {
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        double x = 0.5 + i * 1e-6;
+        double y = 1.5 - i * 1e-6;
+        sum += body(x, y);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+    std::cout << name << ": " << ns << " нс/вызов (контрольная сумма " << sum << ")" << std::endl;
+}
+
+int main() {
+    constexpr auto x = static_expr::var<"x">;
+    constexpr auto y = static_expr::var<"y">;
+    constexpr auto f = sin(x) * exp(y) + (x ^ 3.0) / (1.0 + y * y) - cos(x * y);
+    constexpr auto df = f.derivative<"x">();
+
+    Expression<double> parsed = parseExpression(FORMULA);
+    Expression<double> parsedDerivative = parsed.derivative("x");
+
+    std::cout << "Формула: " << FORMULA << ", итераций: " << ITERATIONS << std::endl;
+
+    run("runtime: parse + evaluate      ", [](double xv, double yv) {
+        return parseExpression(FORMULA).evaluate({{"x", xv}, {"y", yv}});
+    });
+    run("runtime: evaluate              ", [&](double xv, double yv) {
+        return parsed.evaluate({{"x", xv}, {"y", yv}});
+    });
+    run("static:  evaluate              ", [&](double xv, double yv) {
+        return f.evaluate(static_expr::let<"x">(xv), static_expr::let<"y">(yv));
+    });
+    run("runtime: derivative + evaluate ", [&](double xv, double yv) {
+        return parsed.derivative("x").evaluate({{"x", xv}, {"y", yv}});
+    });
+    run("runtime: evaluate derivative   ", [&](double xv, double yv) {
+        return parsedDerivative.evaluate({{"x", xv}, {"y", yv}});
+    });
+    run("static:  evaluate derivative   ", [&](double xv, double yv) {
+        return df.evaluate(static_expr::let<"x">(xv), static_expr::let<"y">(yv));
+    });
+
+    return 0;
+}
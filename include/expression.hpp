@@ -24,6 +24,10 @@ public:
     Expression(Type type, std::unique_ptr<Expression> left, std::unique_ptr<Expression> right);
     ~Expression();
 
+    // Узлы выделяются из пула с потоковыми списками свободных блоков (node_pool.hpp)
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr, std::size_t size);
+
     Expression& operator=(const Expression& other);
     Expression& operator=(Expression&& other) noexcept;
 
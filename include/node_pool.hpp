@@ -0,0 +1,176 @@
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Пул блоков фиксированного размера для узлов Expression<T>.
+// У каждого потока свой список свободных блоков, поэтому выделение и
+// освобождение узла не требуют блокировок. С общим списком потоки
+// обмениваются целыми пачками по BATCH блоков. Память пула в систему не
+// возвращается: блок может быть освобождён в другом потоке и попасть в
+// чужой список.
+template<std::size_t Size>
+class NodePool {
+public:
+    static void* allocate() {
+        Local& l = local;
+        if (!l.head) {
+            if (l.released)
+                return allocateShared();
+            refill(l);
+        }
+        Block* block = l.head;
+        l.head = block->next;
+        --l.count;
+        return block;
+    }
+
+    static void deallocate(void* ptr) {
+        Local& l = local;
+        if (l.released) {
+            deallocateShared(ptr);
+            return;
+        }
+        if (!l.registered)
+            registerThread(l);
+        Block* block = static_cast<Block*>(ptr);
+        block->next = l.head;
+        l.head = block;
+        if (++l.count >= 2 * BATCH)
+            giveBack(l);
+    }
+
+    // Число блоков в общем списке (для тестов)
+    static std::size_t sharedCount() {
+        std::lock_guard<std::mutex> lock(shared().mutex);
+        std::size_t count = 0;
+        for (const Chain& chain : shared().chains)
+            count += chain.count;
+        return count;
+    }
+
+private:
+    struct Block {
+        Block* next;
+    };
+
+    struct Chain {
+        Block* head;
+        std::size_t count;
+    };
+
+    struct Local {
+        Block* head;
+        std::size_t count;
+        bool registered;
+        bool released;
+    };
+
+    struct Shared {
+        std::mutex mutex;
+        std::vector<Chain> chains;
+    };
+
+    // При завершении потока отдаёт его свободные блоки в общий список
+    struct Reaper {
+        ~Reaper() {
+            Local& l = local;
+            if (l.head) {
+                std::lock_guard<std::mutex> lock(shared().mutex);
+                shared().chains.push_back({l.head, l.count});
+            }
+            l.head = nullptr;
+            l.count = 0;
+            l.released = true;
+        }
+    };
+
+    static constexpr std::size_t ALIGN = alignof(std::max_align_t);
+    static constexpr std::size_t BLOCK_SIZE =
+        (std::max(Size, sizeof(Block)) + ALIGN - 1) / ALIGN * ALIGN;
+    static constexpr std::size_t BATCH = 256;
+
+    static inline thread_local Local local {};
+    static inline thread_local Reaper reaper;
+
+    // Не разрушается: узлы в статических объектах могут освобождаться
+    // после завершения main
+    static Shared& shared() {
+        static Shared* instance = new Shared;
+        return *instance;
+    }
+
+    // Поток, который только освобождает чужие узлы, тоже должен отдать их
+    // при завершении, поэтому регистрация нужна и в allocate, и в deallocate
+    static void registerThread(Local& l) {
+        l.registered = true;
+        (void)&reaper;
+    }
+
+    static void refill(Local& l) {
+        if (!l.registered)
+            registerThread(l);
+        {
+            std::lock_guard<std::mutex> lock(shared().mutex);
+            auto& chains = shared().chains;
+            if (!chains.empty()) {
+                l.head = chains.back().head;
+                l.count = chains.back().count;
+                chains.pop_back();
+                return;
+            }
+        }
+        char* chunk = static_cast<char*>(::operator new(BLOCK_SIZE * BATCH));
+        for (std::size_t i = BATCH; i-- > 0;) {
+            Block* block = reinterpret_cast<Block*>(chunk + i * BLOCK_SIZE);
+            block->next = l.head;
+            l.head = block;
+        }
+        l.count = BATCH;
+    }
+
+    static void giveBack(Local& l) {
+        Block* head = l.head;
+        Block* tail = head;
+        for (std::size_t i = 1; i < BATCH; ++i)
+            tail = tail->next;
+        l.head = tail->next;
+        l.count -= BATCH;
+        tail->next = nullptr;
+        std::lock_guard<std::mutex> lock(shared().mutex);
+        shared().chains.push_back({head, BATCH});
+    }
+
+    static void* allocateShared() {
+        {
+            std::lock_guard<std::mutex> lock(shared().mutex);
+            auto& chains = shared().chains;
+            if (!chains.empty()) {
+                Chain& chain = chains.back();
+                Block* block = chain.head;
+                chain.head = block->next;
+                if (--chain.count == 0)
+                    chains.pop_back();
+                return block;
+            }
+        }
+        return ::operator new(BLOCK_SIZE);
+    }
+
+    static void deallocateShared(void* ptr) {
+        Block* block = static_cast<Block*>(ptr);
+        std::lock_guard<std::mutex> lock(shared().mutex);
+        auto& chains = shared().chains;
+        if (chains.empty())
+            chains.push_back({nullptr, 0});
+        block->next = chains.back().head;
+        chains.back().head = block;
+        ++chains.back().count;
+    }
+};
+
+#endif // NODE_POOL_HPP
@@ -0,0 +1,27 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <cstddef>
+#include <string>
+#include "expression.hpp"
+#include "thread_pool.hpp"
+
+// Поддеревья размером не больше порога обрабатываются последовательно
+inline constexpr std::size_t DEFAULT_PARALLEL_CUTOFF = 1024;
+
+// Параллельные аналоги Expression<T>::derivative и Expression<T>::substitute.
+// Цепочки Add/Subtract разбиваются на пачки операндов, у Multiply обе ветви
+// обрабатываются независимо; остальные узлы и небольшие поддеревья
+// обрабатываются последовательным кодом. Результат структурно совпадает с
+// последовательной версией.
+template<typename T>
+Expression<T> parallelDerivative(const Expression<T>& expr, const std::string& var,
+                                 ThreadPool& pool,
+                                 std::size_t cutoff = DEFAULT_PARALLEL_CUTOFF);
+
+template<typename T>
+Expression<T> parallelSubstitute(const Expression<T>& expr, const std::string& var,
+                                 const T& value, ThreadPool& pool,
+                                 std::size_t cutoff = DEFAULT_PARALLEL_CUTOFF);
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,428 @@
+#ifndef STATIC_EXPRESSION_HPP
+#define STATIC_EXPRESSION_HPP
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include "expression.hpp"
+
+// Статический (compile-time) аналог Expression<T>: дерево выражения кодируется
+// типом, поэтому нет ни парсинга, ни выделения памяти, ни switch при вычислении.
+// Производная строится на этапе компиляции и имеет собственный тип.
+//
+//   constexpr auto x = static_expr::var<"x">;
+//   constexpr auto f = sin(x) * (x ^ 2.0);
+//   auto df = f.derivative<"x">();
+//   double v = df.evaluate(static_expr::let<"x">(1.5));
+//   Expression<double> e = df.toExpression();
+//
+// Внимание: у operator^ в C++ приоритет ниже, чем у + и *, поэтому степень
+// нужно заключать в скобки: (x ^ 2.0).
+namespace static_expr {
+
+// --------------------- Имена переменных ---------------------
+
+template<std::size_t N>
+struct Name {
+    char data[N] {};
+
+    constexpr Name(const char (&str)[N]) {
+        for (std::size_t i = 0; i < N; ++i)
+            data[i] = str[i];
+    }
+
+    std::string str() const { return std::string(data, N - 1); }
+};
+
+template<std::size_t A, std::size_t B>
+constexpr bool operator==(const Name<A>& a, const Name<B>& b) {
+    if constexpr (A != B) {
+        return false;
+    } else {
+        for (std::size_t i = 0; i < A; ++i)
+            if (a.data[i] != b.data[i])
+                return false;
+        return true;
+    }
+}
+
+// Значение переменной для evaluate: let<"x">(3.0)
+template<Name N, typename T>
+struct Binding {
+    static constexpr auto name = N;
+    T value;
+};
+
+template<Name N, typename T>
+constexpr Binding<N, T> let(T value) {
+    return Binding<N, T>{value};
+}
+
+template<auto>
+inline constexpr bool dependentFalse = false;
+
+template<Name N, typename T, typename... Bs>
+constexpr T lookup(const Bs&... bs);
+
+template<Name N, typename T, typename B, typename... Bs>
+constexpr T lookupIn(const B& b, const Bs&... bs) {
+    if constexpr (B::name == N)
+        return static_cast<T>(b.value);
+    else
+        return lookup<N, T>(bs...);
+}
+
+template<Name N, typename T, typename... Bs>
+constexpr T lookup(const Bs&... bs) {
+    if constexpr (sizeof...(Bs) == 0) {
+        static_assert(dependentFalse<N>, "Не задано значение для переменной");
+        return T();
+    } else {
+        return lookupIn<N, T>(bs...);
+    }
+}
+
+// --------------------- Узлы дерева ---------------------
+
+struct Node {};
+
+template<typename E>
+concept StaticExpr = std::is_base_of_v<Node, E>;
+
+template<typename T>
+struct Zero : Node {
+    using value_type = T;
+
+    constexpr T value() const { return static_cast<T>(0); }
+
+    template<typename... Bs>
+    constexpr T evaluate(const Bs&...) const { return static_cast<T>(0); }
+
+    template<Name V>
+    constexpr auto derivative() const { return Zero<T>{}; }
+
+    Expression<T> toExpression() const { return Expression<T>(value()); }
+};
+
+template<typename T>
+struct One : Node {
+    using value_type = T;
+
+    constexpr T value() const { return static_cast<T>(1); }
+
+    template<typename... Bs>
+    constexpr T evaluate(const Bs&...) const { return static_cast<T>(1); }
+
+    template<Name V>
+    constexpr auto derivative() const { return Zero<T>{}; }
+
+    Expression<T> toExpression() const { return Expression<T>(value()); }
+};
+
+template<typename T>
+struct Const : Node {
+    using value_type = T;
+
+    T v;
+
+    constexpr Const(T v) : v(v) {}
+
+    constexpr T value() const { return v; }
+
+    template<typename... Bs>
+    constexpr T evaluate(const Bs&...) const { return v; }
+
+    template<Name V>
+    constexpr auto derivative() const { return Zero<T>{}; }
+
+    Expression<T> toExpression() const { return Expression<T>(v); }
+};
+
+template<typename T, Name N>
+struct Var : Node {
+    using value_type = T;
+
+    template<typename... Bs>
+    constexpr T evaluate(const Bs&... bs) const { return lookup<N, T>(bs...); }
+
+    template<Name V>
+    constexpr auto derivative() const {
+        if constexpr (N == V)
+            return One<T>{};
+        else
+            return Zero<T>{};
+    }
+
+    Expression<T> toExpression() const { return Expression<T>(N.str()); }
+};
+
+template<Name N, typename T = double>
+inline constexpr Var<T, N> var{};
+
+template<typename E>
+struct IsConstant : std::false_type {};
+template<typename T>
+struct IsConstant<Zero<T>> : std::true_type {};
+template<typename T>
+struct IsConstant<One<T>> : std::true_type {};
+template<typename T>
+struct IsConstant<Const<T>> : std::true_type {};
+
+template<typename E>
+inline constexpr bool isZero = false;
+template<typename T>
+inline constexpr bool isZero<Zero<T>> = true;
+
+template<typename E>
+inline constexpr bool isOne = false;
+template<typename T>
+inline constexpr bool isOne<One<T>> = true;
+
+// --------------------- Операции ---------------------
+
+struct AddOp {
+    template<typename T> static constexpr auto type = Expression<T>::Type::Add;
+    template<typename T> static constexpr T apply(const T& a, const T& b) { return a + b; }
+};
+
+struct SubtractOp {
+    template<typename T> static constexpr auto type = Expression<T>::Type::Subtract;
+    template<typename T> static constexpr T apply(const T& a, const T& b) { return a - b; }
+};
+
+struct MultiplyOp {
+    template<typename T> static constexpr auto type = Expression<T>::Type::Multiply;
+    template<typename T> static constexpr T apply(const T& a, const T& b) { return a * b; }
+};
+
+struct DivideOp {
+    template<typename T> static constexpr auto type = Expression<T>::Type::Divide;
+    template<typename T> static constexpr T apply(const T& a, const T& b) { return a / b; }
+};
+
+struct PowerOp {
+    template<typename T> static constexpr auto type = Expression<T>::Type::Power;
+    template<typename T> static constexpr T apply(const T& a, const T& b) { return std::pow(a, b); }
+};
+
+struct SinOp {
+    template<typename T> static constexpr auto type = Expression<T>::Type::Sin;
+    template<typename T> static constexpr T apply(const T& a) { return std::sin(a); }
+};
+
+struct CosOp {
+    template<typename T> static constexpr auto type = Expression<T>::Type::Cos;
+    template<typename T> static constexpr T apply(const T& a) { return std::cos(a); }
+};
+
+struct LnOp {
+    template<typename T> static constexpr auto type = Expression<T>::Type::Ln;
+    template<typename T> static constexpr T apply(const T& a) { return std::log(a); }
+};
+
+struct ExpOp {
+    template<typename T> static constexpr auto type = Expression<T>::Type::Exp;
+    template<typename T> static constexpr T apply(const T& a) { return std::exp(a); }
+};
+
+template<typename Op, StaticExpr L, StaticExpr R>
+struct Binary;
+
+template<typename Op, StaticExpr A>
+struct Unary;
+
+template<StaticExpr L, StaticExpr R> using Add = Binary<AddOp, L, R>;
+template<StaticExpr L, StaticExpr R> using Subtract = Binary<SubtractOp, L, R>;
+template<StaticExpr L, StaticExpr R> using Multiply = Binary<MultiplyOp, L, R>;
+template<StaticExpr L, StaticExpr R> using Divide = Binary<DivideOp, L, R>;
+template<StaticExpr L, StaticExpr R> using Power = Binary<PowerOp, L, R>;
+template<StaticExpr A> using Sin = Unary<SinOp, A>;
+template<StaticExpr A> using Cos = Unary<CosOp, A>;
+template<StaticExpr A> using Ln = Unary<LnOp, A>;
+template<StaticExpr A> using Exp = Unary<ExpOp, A>;
+
+// Конструкторы узлов с упрощением нулей и единиц; используются только при
+// построении производной, чтобы в её тип не попадали заведомо пустые ветви.
+template<StaticExpr L, StaticExpr R>
+constexpr auto makeAdd(const L& l, const R& r) {
+    if constexpr (isZero<L>)
+        return r;
+    else if constexpr (isZero<R>)
+        return l;
+    else
+        return Add<L, R>(l, r);
+}
+
+template<StaticExpr L, StaticExpr R>
+constexpr auto makeSubtract(const L& l, const R& r) {
+    if constexpr (isZero<R>)
+        return l;
+    else
+        return Subtract<L, R>(l, r);
+}
+
+template<StaticExpr L, StaticExpr R>
+constexpr auto makeMultiply(const L& l, const R& r) {
+    if constexpr (isZero<L>)
+        return l;
+    else if constexpr (isZero<R>)
+        return r;
+    else if constexpr (isOne<L>)
+        return r;
+    else if constexpr (isOne<R>)
+        return l;
+    else
+        return Multiply<L, R>(l, r);
+}
+
+template<StaticExpr L, StaticExpr R>
+constexpr auto makeDivide(const L& l, const R& r) {
+    if constexpr (isZero<L>)
+        return l;
+    else if constexpr (isOne<R>)
+        return l;
+    else
+        return Divide<L, R>(l, r);
+}
+
+template<typename Op, StaticExpr L, StaticExpr R>
+struct Binary : Node {
+    using value_type = typename L::value_type;
+    static_assert(std::is_same_v<value_type, typename R::value_type>,
+                  "Операнды должны иметь одинаковый тип значения");
+    using T = value_type;
+
+    L left;
+    R right;
+
+    constexpr Binary(const L& left, const R& right) : left(left), right(right) {}
+
+    template<typename... Bs>
+    constexpr T evaluate(const Bs&... bs) const {
+        return Op::apply(left.evaluate(bs...), right.evaluate(bs...));
+    }
+
+    template<Name V>
+    constexpr auto derivative() const {
+        auto dl = left.template derivative<V>();
+        auto dr = right.template derivative<V>();
+        if constexpr (std::is_same_v<Op, AddOp>) {
+            return makeAdd(dl, dr);
+        } else if constexpr (std::is_same_v<Op, SubtractOp>) {
+            return makeSubtract(dl, dr);
+        } else if constexpr (std::is_same_v<Op, MultiplyOp>) {
+            return makeAdd(makeMultiply(dl, right), makeMultiply(left, dr));
+        } else if constexpr (std::is_same_v<Op, DivideOp>) {
+            return makeDivide(makeSubtract(makeMultiply(dl, right), makeMultiply(left, dr)),
+                              Power<R, Const<T>>(right, Const<T>(static_cast<T>(2))));
+        } else if constexpr (IsConstant<R>::value) {
+            T c = right.value();
+            return makeMultiply(
+                makeMultiply(Const<T>(c),
+                             Power<L, Const<T>>(left, Const<T>(c - static_cast<T>(1)))),
+                dl);
+        } else {
+            return makeMultiply(*this,
+                makeAdd(makeMultiply(dr, Ln<L>(left)),
+                        makeDivide(makeMultiply(right, dl), left)));
+        }
+    }
+
+    Expression<T> toExpression() const {
+        return Expression<T>(Op::template type<T>,
+            std::unique_ptr<Expression<T>>(new Expression<T>(left.toExpression())),
+            std::unique_ptr<Expression<T>>(new Expression<T>(right.toExpression())));
+    }
+};
+
+template<typename Op, StaticExpr A>
+struct Unary : Node {
+    using value_type = typename A::value_type;
+    using T = value_type;
+
+    A arg;
+
+    constexpr explicit Unary(const A& arg) : arg(arg) {}
+
+    template<typename... Bs>
+    constexpr T evaluate(const Bs&... bs) const {
+        return Op::apply(arg.evaluate(bs...));
+    }
+
+    template<Name V>
+    constexpr auto derivative() const {
+        auto da = arg.template derivative<V>();
+        if constexpr (std::is_same_v<Op, SinOp>) {
+            return makeMultiply(Cos<A>(arg), da);
+        } else if constexpr (std::is_same_v<Op, CosOp>) {
+            return makeMultiply(makeMultiply(Const<T>(static_cast<T>(-1)), Sin<A>(arg)), da);
+        } else if constexpr (std::is_same_v<Op, LnOp>) {
+            return makeDivide(da, arg);
+        } else {
+            return makeMultiply(*this, da);
+        }
+    }
+
+    Expression<T> toExpression() const {
+        return Expression<T>(Op::template type<T>,
+            std::unique_ptr<Expression<T>>(new Expression<T>(arg.toExpression())),
+            nullptr);
+    }
+};
+
+// --------------------- Арифметические операторы ---------------------
+
+template<StaticExpr L, StaticExpr R>
+constexpr Add<L, R> operator+(const L& l, const R& r) { return Add<L, R>(l, r); }
+
+template<StaticExpr L, StaticExpr R>
+constexpr Subtract<L, R> operator-(const L& l, const R& r) { return Subtract<L, R>(l, r); }
+
+template<StaticExpr L, StaticExpr R>
+constexpr Multiply<L, R> operator*(const L& l, const R& r) { return Multiply<L, R>(l, r); }
+
+template<StaticExpr L, StaticExpr R>
+constexpr Divide<L, R> operator/(const L& l, const R& r) { return Divide<L, R>(l, r); }
+
+template<StaticExpr L, StaticExpr R>
+constexpr Power<L, R> operator^(const L& l, const R& r) { return Power<L, R>(l, r); }
+
+// Смешанные операции с числами: число становится узлом Const<T>
+#define STATIC_EXPR_SCALAR_OPERATOR(op, Node)                                         \
+    template<StaticExpr L>                                                            \
+    constexpr auto operator op(const L& l, typename L::value_type c) {                \
+        return Node<L, Const<typename L::value_type>>(l, Const<typename L::value_type>(c)); \
+    }                                                                                 \
+    template<StaticExpr R>                                                            \
+    constexpr auto operator op(typename R::value_type c, const R& r) {                \
+        return Node<Const<typename R::value_type>, R>(Const<typename R::value_type>(c), r); \
+    }
+
+STATIC_EXPR_SCALAR_OPERATOR(+, Add)
+STATIC_EXPR_SCALAR_OPERATOR(-, Subtract)
+STATIC_EXPR_SCALAR_OPERATOR(*, Multiply)
+STATIC_EXPR_SCALAR_OPERATOR(/, Divide)
+STATIC_EXPR_SCALAR_OPERATOR(^, Power)
+
+#undef STATIC_EXPR_SCALAR_OPERATOR
+
+// --------------------- Функции (sin, cos, ln, exp) ---------------------
+
+template<StaticExpr A>
+constexpr Sin<A> sin(const A& a) { return Sin<A>(a); }
+
+template<StaticExpr A>
+constexpr Cos<A> cos(const A& a) { return Cos<A>(a); }
+
+template<StaticExpr A>
+constexpr Ln<A> ln(const A& a) { return Ln<A>(a); }
+
+template<StaticExpr A>
+constexpr Exp<A> exp(const A& a) { return Exp<A>(a); }
+
+} // namespace static_expr
+
+#endif // STATIC_EXPRESSION_HPP
@@ -0,0 +1,102 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Пул потоков с перехватом задач (work stealing): у каждого рабочего потока
+// своя очередь, свои задачи он берёт с конца, чужие крадёт с начала.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const;
+
+    // Из рабочего потока задача попадает в его очередь, иначе - в очереди по кругу
+    void submit(Task task);
+
+    // Выполняет одну задачу (свою или украденную); false, если задач нет
+    bool runPending();
+
+    bool isWorkerThread() const;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(std::size_t index);
+    bool popOwn(std::size_t index, Task& task);
+    bool steal(std::size_t thief, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> queued{0};
+    std::atomic<std::size_t> sleeping{0};
+    std::atomic<std::size_t> nextQueue{0};
+    std::atomic<bool> stopping{false};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+};
+
+// Группа задач fork-join. Ожидающий рабочий поток не простаивает, а
+// выполняет другие задачи пула. Первое исключение из задач пробрасывается
+// из wait().
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template<typename F>
+    void spawn(F&& f) {
+        state->pending.fetch_add(1, std::memory_order_relaxed);
+        pool.submit([state = state, f = std::forward<F>(f)]() mutable {
+            try {
+                f();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->errorMutex);
+                if (!state->error)
+                    state->error = std::current_exception();
+            }
+            if (state->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                state->pending.notify_all();
+        });
+    }
+
+    void wait();
+
+private:
+    // Задача держит состояние сама, поэтому группа может быть разрушена
+    // сразу после того, как счётчик дошёл до нуля
+    struct State {
+        std::atomic<std::size_t> pending{0};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+
+    void join();
+
+    ThreadPool& pool;
+    std::shared_ptr<State> state;
+};
+
+#endif // THREAD_POOL_HPP
@@ -1,4 +1,5 @@
 #include "expression.hpp"
+#include "node_pool.hpp"
 #include <cmath>
 #include <complex>
 #include <stdexcept>
@@ -41,6 +42,22 @@ Expression<T>::Expression(typename Expression<T>::Type type,
 template<typename T>
 Expression<T>::~Expression() {}
 
+template<typename T>
+void* Expression<T>::operator new(std::size_t size) {
+    if (size != sizeof(Expression))
+        return ::operator new(size);
+    return NodePool<sizeof(Expression)>::allocate();
+}
+
+template<typename T>
+void Expression<T>::operator delete(void* ptr, std::size_t size) {
+    if (size != sizeof(Expression)) {
+        ::operator delete(ptr);
+        return;
+    }
+    NodePool<sizeof(Expression)>::deallocate(ptr);
+}
+
 template<typename T>
 Expression<T>& Expression<T>::operator=(const Expression& other) {
     if (this != &other) {
@@ -73,83 +90,75 @@ Expression<T>& Expression<T>::operator=(Expression&& other) noexcept {
 
 // --------------------- Арифметические операторы ---------------------
 
+// Узел операции из операндов, переданных по значению: временные выражения
+// перемещаются, а не копируются. value и variable узла берутся из левого
+// операнда.
 template<typename T>
-Expression<T> Expression<T>::operator+(const Expression& other) const {
-    Expression result(*this);
-    result.type = Type::Add;
-    result.left = std::unique_ptr<Expression>(new Expression(*this));
-    result.right = std::unique_ptr<Expression>(new Expression(other));
+static Expression<T> makeNode(typename Expression<T>::Type type,
+                              Expression<T> left, Expression<T> right) {
+    Expression<T> result(type,
+        std::unique_ptr<Expression<T>>(new Expression<T>(std::move(left))),
+        std::unique_ptr<Expression<T>>(new Expression<T>(std::move(right))));
+    result.value = result.left->value;
+    result.variable = result.left->variable;
     return result;
 }
 
 template<typename T>
-Expression<T> Expression<T>::operator-(const Expression& other) const {
-    Expression result(*this);
-    result.type = Type::Subtract;
-    result.left = std::unique_ptr<Expression>(new Expression(*this));
-    result.right = std::unique_ptr<Expression>(new Expression(other));
+static Expression<T> makeNode(typename Expression<T>::Type type, Expression<T> arg) {
+    Expression<T> result(type,
+        std::unique_ptr<Expression<T>>(new Expression<T>(std::move(arg))),
+        nullptr);
+    result.value = result.left->value;
+    result.variable = result.left->variable;
     return result;
 }
 
+template<typename T>
+Expression<T> Expression<T>::operator+(const Expression& other) const {
+    return makeNode(Type::Add, *this, other);
+}
+
+template<typename T>
+Expression<T> Expression<T>::operator-(const Expression& other) const {
+    return makeNode(Type::Subtract, *this, other);
+}
+
 template<typename T>
 Expression<T> Expression<T>::operator*(const Expression& other) const {
-    Expression result(*this);
-    result.type = Type::Multiply;
-    result.left = std::unique_ptr<Expression>(new Expression(*this));
-    result.right = std::unique_ptr<Expression>(new Expression(other));
-    return result;
+    return makeNode(Type::Multiply, *this, other);
 }
 
 template<typename T>
 Expression<T> Expression<T>::operator/(const Expression& other) const {
-    Expression result(*this);
-    result.type = Type::Divide;
-    result.left = std::unique_ptr<Expression>(new Expression(*this));
-    result.right = std::unique_ptr<Expression>(new Expression(other));
-    return result;
+    return makeNode(Type::Divide, *this, other);
 }
 
 template<typename T>
 Expression<T> Expression<T>::operator^(const Expression& other) const {
-    Expression result(*this);
-    result.type = Type::Power;
-    result.left = std::unique_ptr<Expression>(new Expression(*this));
-    result.right = std::unique_ptr<Expression>(new Expression(other));
-    return result;
+    return makeNode(Type::Power, *this, other);
 }
 
 // --------------------- Функции (sin, cos, ln, exp) ---------------------
 
 template<typename T>
 Expression<T> Expression<T>::sin(const Expression& expr) {
-    Expression result(expr);
-    result.type = Type::Sin;
-    result.left = std::unique_ptr<Expression>(new Expression(expr));
-    return result;
+    return makeNode(Type::Sin, expr);
 }
 
 template<typename T>
 Expression<T> Expression<T>::cos(const Expression& expr) {
-    Expression result(expr);
-    result.type = Type::Cos;
-    result.left = std::unique_ptr<Expression>(new Expression(expr));
-    return result;
+    return makeNode(Type::Cos, expr);
 }
 
 template<typename T>
 Expression<T> Expression<T>::ln(const Expression& expr) {
-    Expression result(expr);
-    result.type = Type::Ln;
-    result.left = std::unique_ptr<Expression>(new Expression(expr));
-    return result;
+    return makeNode(Type::Ln, expr);
 }
 
 template<typename T>
 Expression<T> Expression<T>::exp(const Expression& expr) {
-    Expression result(expr);
-    result.type = Type::Exp;
-    result.left = std::unique_ptr<Expression>(new Expression(expr));
-    return result;
+    return makeNode(Type::Exp, expr);
 }
 
 // --------------------- Подстановка и вычисление ---------------------
@@ -163,12 +172,12 @@ Expression<T> Expression<T>::substitute(const std::string& var, const T& val) co
         auto newLeft = left->substitute(var, val);
         auto newRight = right->substitute(var, val);
         return Expression<T>(type,
-            std::unique_ptr<Expression>(new Expression(newLeft)),
-            std::unique_ptr<Expression>(new Expression(newRight)));
+            std::unique_ptr<Expression>(new Expression(std::move(newLeft))),
+            std::unique_ptr<Expression>(new Expression(std::move(newRight))));
     } else if (left) {
         auto newLeft = left->substitute(var, val);
         return Expression<T>(type,
-            std::unique_ptr<Expression>(new Expression(newLeft)),
+            std::unique_ptr<Expression>(new Expression(std::move(newLeft))),
             nullptr);
     }
     return *this;
@@ -277,38 +286,48 @@ Expression<T> Expression<T>::derivative(const std::string& var) const {
             return (variable == var) ? Expression<T>(static_cast<T>(1))
                                      : Expression<T>(static_cast<T>(0));
         case Type::Add:
-            return left->derivative(var) + right->derivative(var);
+            return makeNode(Type::Add, left->derivative(var), right->derivative(var));
         case Type::Subtract:
-            return left->derivative(var) - right->derivative(var);
+            return makeNode(Type::Subtract, left->derivative(var), right->derivative(var));
         case Type::Multiply:
-            return (left->derivative(var) * (*right)) +
-                   ((*left) * right->derivative(var));
+            return makeNode(Type::Add,
+                            makeNode(Type::Multiply, left->derivative(var), *right),
+                            makeNode(Type::Multiply, *left, right->derivative(var)));
         case Type::Divide:
-            return ((left->derivative(var) * (*right))
-                    - ((*left) * right->derivative(var)))
-                    / ((*right) ^ Expression<T>(static_cast<T>(2)));
+            return makeNode(Type::Divide,
+                            makeNode(Type::Subtract,
+                                     makeNode(Type::Multiply, left->derivative(var), *right),
+                                     makeNode(Type::Multiply, *left, right->derivative(var))),
+                            makeNode(Type::Power, *right, Expression<T>(static_cast<T>(2))));
         case Type::Power:
             if (right->type == Type::Constant) {
                 T c = right->value;
-                return Expression<T>(c)
-                       * ((*left) ^ Expression<T>(c - static_cast<T>(1)))
-                       * left->derivative(var);
+                return makeNode(Type::Multiply,
+                                makeNode(Type::Multiply, Expression<T>(c),
+                                         makeNode(Type::Power, *left,
+                                                  Expression<T>(c - static_cast<T>(1)))),
+                                left->derivative(var));
             } else {
-                return (*this) * (
-                    right->derivative(var) * Expression<T>::ln(*left)
-                    + (*right) * left->derivative(var) / (*left)
-                );
+                return makeNode(Type::Multiply, *this,
+                                makeNode(Type::Add,
+                                         makeNode(Type::Multiply, right->derivative(var),
+                                                  makeNode(Type::Ln, *left)),
+                                         makeNode(Type::Divide,
+                                                  makeNode(Type::Multiply, *right,
+                                                           left->derivative(var)),
+                                                  *left)));
             }
         case Type::Sin:
-            return Expression<T>::cos(*left) * left->derivative(var);
+            return makeNode(Type::Multiply, makeNode(Type::Cos, *left), left->derivative(var));
         case Type::Cos:
-            return Expression<T>(static_cast<T>(-1))
-                   * Expression<T>::sin(*left)
-                   * left->derivative(var);
+            return makeNode(Type::Multiply,
+                            makeNode(Type::Multiply, Expression<T>(static_cast<T>(-1)),
+                                     makeNode(Type::Sin, *left)),
+                            left->derivative(var));
         case Type::Ln:
-            return left->derivative(var) / (*left);
+            return makeNode(Type::Divide, left->derivative(var), *left);
         case Type::Exp:
-            return Expression<T>::exp(*left) * left->derivative(var);
+            return makeNode(Type::Multiply, makeNode(Type::Exp, *left), left->derivative(var));
     }
     throw std::runtime_error("Derivative not implemented for this expression type");
 }
@@ -0,0 +1,217 @@
+#include "parallel.hpp"
+#include <complex>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// --------------------- Вспомогательные функции ---------------------
+
+// Число узлов поддерева, но не больше limit + 1
+template<typename T>
+static void countNodes(const Expression<T>& expr, std::size_t limit, std::size_t& count) {
+    if (count > limit)
+        return;
+    ++count;
+    if (expr.left)
+        countNodes(*expr.left, limit, count);
+    if (expr.right)
+        countNodes(*expr.right, limit, count);
+}
+
+template<typename T>
+static std::size_t sizeUpTo(const Expression<T>& expr, std::size_t limit) {
+    std::size_t count = 0;
+    countNodes(expr, limit, count);
+    return count;
+}
+
+// --------------------- Параллельный обход ---------------------
+
+template<typename T>
+class ParallelTransform {
+public:
+    enum class Mode { Derivative, Substitute };
+
+    ParallelTransform(Mode mode, const std::string& var, const T& value,
+                      ThreadPool& pool, std::size_t cutoff)
+        : mode(mode), var(var), value(value), pool(pool), cutoff(cutoff) {}
+
+    Expression<T> run(const Expression<T>& expr) {
+        if (sizeUpTo(expr, cutoff) <= cutoff)
+            return sequential(expr);
+        std::optional<Expression<T>> result;
+        TaskGroup group(pool);
+        group.spawn([&] { result.emplace(transform(expr)); });
+        group.wait();
+        return std::move(*result);
+    }
+
+private:
+    using Type = typename Expression<T>::Type;
+
+    Expression<T> sequential(const Expression<T>& expr) const {
+        if (mode == Mode::Derivative)
+            return expr.derivative(var);
+        return expr.substitute(var, value);
+    }
+
+    Expression<T> transform(const Expression<T>& expr) {
+        switch (expr.type) {
+            case Type::Add:
+            case Type::Subtract:
+                return transformSum(expr);
+            case Type::Multiply:
+                return transformProduct(expr);
+            default:
+                return sequential(expr);
+        }
+    }
+
+    Expression<T> transformOperand(const Expression<T>& expr, std::size_t size) {
+        return size > cutoff ? transform(expr) : sequential(expr);
+    }
+
+    // Узел из готовых операндов без копирования. Для производной повторяет
+    // операторы Expression<T>, которые берут value и variable из левого операнда.
+    Expression<T> join(Type type, Expression<T>&& left, Expression<T>&& right) const {
+        Expression<T> result(type,
+            std::unique_ptr<Expression<T>>(new Expression<T>(std::move(left))),
+            std::unique_ptr<Expression<T>>(new Expression<T>(std::move(right))));
+        if (mode == Mode::Derivative) {
+            result.value = result.left->value;
+            result.variable = result.left->variable;
+        }
+        return result;
+    }
+
+    static bool isSum(const Expression<T>& expr) {
+        return expr.type == Type::Add || expr.type == Type::Subtract;
+    }
+
+    static void collectOperands(const Expression<T>& expr,
+                                std::vector<const Expression<T>*>& operands) {
+        if (isSum(expr)) {
+            collectOperands(*expr.left, operands);
+            collectOperands(*expr.right, operands);
+        } else {
+            operands.push_back(&expr);
+        }
+    }
+
+    Expression<T> rebuildSum(const Expression<T>& expr,
+                             std::vector<std::optional<Expression<T>>>& results,
+                             std::size_t& next) const {
+        if (!isSum(expr))
+            return std::move(*results[next++]);
+        Expression<T> left = rebuildSum(*expr.left, results, next);
+        Expression<T> right = rebuildSum(*expr.right, results, next);
+        return join(expr.type, std::move(left), std::move(right));
+    }
+
+    // Цепочка Add/Subtract: операнды делятся на пачки примерно по cutoff узлов,
+    // затем цепочка собирается заново в исходной форме
+    Expression<T> transformSum(const Expression<T>& expr) {
+        std::vector<const Expression<T>*> operands;
+        collectOperands(expr, operands);
+
+        std::vector<std::size_t> sizes(operands.size());
+        for (std::size_t i = 0; i < operands.size(); ++i)
+            sizes[i] = sizeUpTo(*operands[i], cutoff);
+
+        std::vector<std::optional<Expression<T>>> results(operands.size());
+        auto process = [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i)
+                results[i].emplace(transformOperand(*operands[i], sizes[i]));
+        };
+        {
+            TaskGroup group(pool);
+            std::size_t begin = 0;
+            std::size_t weight = 0;
+            for (std::size_t i = 0; i + 1 < operands.size(); ++i) {
+                weight += sizes[i];
+                if (weight >= cutoff) {
+                    group.spawn([&process, begin, end = i + 1] { process(begin, end); });
+                    begin = i + 1;
+                    weight = 0;
+                }
+            }
+            process(begin, operands.size());
+            group.wait();
+        }
+
+        std::size_t next = 0;
+        return rebuildSum(expr, results, next);
+    }
+
+    template<typename F>
+    static void fork(TaskGroup& group, bool parallel, F&& f) {
+        if (parallel)
+            group.spawn(std::forward<F>(f));
+        else
+            f();
+    }
+
+    // Multiply: ветви (и копии операндов для производной) независимы
+    Expression<T> transformProduct(const Expression<T>& expr) {
+        const Expression<T>& left = *expr.left;
+        const Expression<T>& right = *expr.right;
+        std::size_t leftSize = sizeUpTo(left, cutoff);
+        std::size_t rightSize = sizeUpTo(right, cutoff);
+        bool leftLarge = leftSize > cutoff;
+        bool rightLarge = rightSize > cutoff;
+
+        if (mode == Mode::Substitute) {
+            std::optional<Expression<T>> newLeft;
+            TaskGroup group(pool);
+            fork(group, leftLarge, [&] { newLeft.emplace(transformOperand(left, leftSize)); });
+            Expression<T> newRight = transformOperand(right, rightSize);
+            group.wait();
+            return join(Type::Multiply, std::move(*newLeft), std::move(newRight));
+        }
+
+        // (dl * r) + (l * dr), как в Expression<T>::derivative
+        std::optional<Expression<T>> dl, leftCopy, rightCopy;
+        TaskGroup group(pool);
+        fork(group, leftLarge, [&] { dl.emplace(transformOperand(left, leftSize)); });
+        fork(group, leftLarge, [&] { leftCopy.emplace(left); });
+        fork(group, rightLarge, [&] { rightCopy.emplace(right); });
+        Expression<T> dr = transformOperand(right, rightSize);
+        group.wait();
+        return join(Type::Add,
+                    join(Type::Multiply, std::move(*dl), std::move(*rightCopy)),
+                    join(Type::Multiply, std::move(*leftCopy), std::move(dr)));
+    }
+
+    Mode mode;
+    const std::string& var;
+    T value;
+    ThreadPool& pool;
+    std::size_t cutoff;
+};
+
+// --------------------- Точки входа ---------------------
+
+template<typename T>
+Expression<T> parallelDerivative(const Expression<T>& expr, const std::string& var,
+                                 ThreadPool& pool, std::size_t cutoff) {
+    using Transform = ParallelTransform<T>;
+    return Transform(Transform::Mode::Derivative, var, T(), pool, cutoff).run(expr);
+}
+
+template<typename T>
+Expression<T> parallelSubstitute(const Expression<T>& expr, const std::string& var,
+                                 const T& value, ThreadPool& pool, std::size_t cutoff) {
+    using Transform = ParallelTransform<T>;
+    return Transform(Transform::Mode::Substitute, var, value, pool, cutoff).run(expr);
+}
+
+template Expression<double> parallelDerivative<double>(
+    const Expression<double>&, const std::string&, ThreadPool&, std::size_t);
+template Expression<std::complex<double>> parallelDerivative<std::complex<double>>(
+    const Expression<std::complex<double>>&, const std::string&, ThreadPool&, std::size_t);
+template Expression<double> parallelSubstitute<double>(
+    const Expression<double>&, const std::string&, const double&, ThreadPool&, std::size_t);
+template Expression<std::complex<double>> parallelSubstitute<std::complex<double>>(
+    const Expression<std::complex<double>>&, const std::string&, const std::complex<double>&,
+    ThreadPool&, std::size_t);
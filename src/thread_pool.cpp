@@ -0,0 +1,138 @@
+#include "thread_pool.hpp"
+
+namespace {
+
+thread_local ThreadPool* currentPool = nullptr;
+thread_local std::size_t currentIndex = 0;
+
+} // namespace
+
+// --------------------- ThreadPool ---------------------
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    if (threads == 0)
+        threads = 1;
+    for (std::size_t i = 0; i < threads; ++i)
+        queues.push_back(std::make_unique<Queue>());
+    for (std::size_t i = 0; i < threads; ++i)
+        workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCondition.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+std::size_t ThreadPool::size() const {
+    return workers.size();
+}
+
+bool ThreadPool::isWorkerThread() const {
+    return currentPool == this;
+}
+
+void ThreadPool::submit(Task task) {
+    std::size_t index = isWorkerThread()
+        ? currentIndex
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1);
+    if (sleeping.load() > 0) {
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        sleepCondition.notify_one();
+    }
+}
+
+bool ThreadPool::runPending() {
+    Task task;
+    std::size_t index = isWorkerThread() ? currentIndex : 0;
+    if ((isWorkerThread() && popOwn(index, task)) || steal(index, task)) {
+        task();
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::popOwn(std::size_t index, Task& task) {
+    Queue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queued.fetch_sub(1);
+    return true;
+}
+
+bool ThreadPool::steal(std::size_t thief, Task& task) {
+    for (std::size_t i = 1; i <= queues.size(); ++i) {
+        Queue& queue = *queues[(thief + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(std::size_t index) {
+    currentPool = this;
+    currentIndex = index;
+    while (true) {
+        Task task;
+        if (popOwn(index, task) || steal(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleeping.fetch_add(1);
+        sleepCondition.wait(lock, [this] { return stopping || queued.load() > 0; });
+        sleeping.fetch_sub(1);
+        if (stopping && queued.load() == 0)
+            return;
+    }
+}
+
+// --------------------- TaskGroup ---------------------
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : pool(pool), state(std::make_shared<State>()) {}
+
+TaskGroup::~TaskGroup() {
+    join();
+}
+
+void TaskGroup::join() {
+    if (pool.isWorkerThread()) {
+        while (state->pending.load(std::memory_order_acquire) != 0) {
+            if (!pool.runPending())
+                std::this_thread::yield();
+        }
+    } else {
+        std::size_t pending;
+        while ((pending = state->pending.load(std::memory_order_acquire)) != 0)
+            state->pending.wait(pending, std::memory_order_acquire);
+    }
+}
+
+void TaskGroup::wait() {
+    join();
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(state->errorMutex);
+        std::swap(error, state->error);
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
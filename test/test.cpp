@@ -1,7 +1,13 @@
 #include <iostream>
 #include <map>
+#include <memory>
+#include <thread>
+#include <vector>
 #include "expression.hpp"
 #include "parser.hpp"
+#include "parallel.hpp"
+#include "node_pool.hpp"
+#include "static_expression.hpp"
 
 static void check(bool condition, const std::string& testName) {
     if (condition) {
@@ -11,6 +17,15 @@ static void check(bool condition, const std::string& testName) {
     }
 }
 
+template<typename T>
+static bool sameTree(const Expression<T>& a, const Expression<T>& b) {
+    if (a.type != b.type || a.value != b.value || a.variable != b.variable)
+        return false;
+    if (!a.left != !b.left || !a.right != !b.right)
+        return false;
+    return (!a.left || sameTree(*a.left, *b.left)) && (!a.right || sameTree(*a.right, *b.right));
+}
+
 int main() {
     // Тест 1: парсинг и вычисление "2+2"
     {
@@ -51,5 +66,82 @@ int main() {
               "d/dx(sin(x)) = cos(x)");
     }
 
+    // Тест 6: статическое выражение вычисляется и дифференцируется при компиляции
+    {
+        constexpr auto x = static_expr::var<"x">;
+        constexpr auto f = x * x + 3.0 * x;
+        constexpr auto df = f.derivative<"x">();
+        static_assert(f.evaluate(static_expr::let<"x">(2.0)) == 10.0);
+        static_assert(df.evaluate(static_expr::let<"x">(2.0)) == 7.0);
+        check(df.evaluate(static_expr::let<"x">(5.0)) == 13.0,
+              "static: d/dx(x*x + 3*x) при x=5 => 13");
+    }
+
+    // Тест 7: статическая производная совпадает с динамической
+    {
+        constexpr auto x = static_expr::var<"x">;
+        constexpr auto y = static_expr::var<"y">;
+        auto f = sin(x) * exp(y) + (x ^ 3.0) / (1.0 + ln(y)) - cos(x * y);
+        Expression<double> runtime = parseExpression("sin(x)*exp(y) + x^3/(1 + ln(y)) - cos(x*y)");
+        bool same = true;
+        for (const char* var : {"x", "y"}) {
+            Expression<double> d = runtime.derivative(var);
+            for (double xv : {0.3, 1.7}) {
+                for (double yv : {0.5, 2.5}) {
+                    double expected = d.evaluate({{"x", xv}, {"y", yv}});
+                    double actual = std::string(var) == "x"
+                        ? f.derivative<"x">().evaluate(static_expr::let<"x">(xv), static_expr::let<"y">(yv))
+                        : f.derivative<"y">().evaluate(static_expr::let<"y">(yv), static_expr::let<"x">(xv));
+                    same = same && std::abs(expected - actual) < 1e-9;
+                }
+            }
+        }
+        check(same, "static: производная совпадает с Expression<T>::derivative");
+    }
+
+    // Тест 8: преобразование в Expression<T>
+    {
+        constexpr auto x = static_expr::var<"x">;
+        Expression<double> e = (sin(x) * (x ^ 2.0)).toExpression();
+        check(e.toString() == parseExpression("sin(x) * x^2").toString(),
+              "static: toExpression() даёт то же дерево, что и парсер");
+        Expression<double> d = (x ^ 2.0).derivative<"x">().toExpression();
+        check(d.evaluate({{"x", 3.0}}) == 6.0, "static: toExpression() производной x^2 при x=3 => 6");
+    }
+
+    // Тест 9: параллельная производная и подстановка совпадают с последовательными
+    {
+        std::string source = "x*y";
+        for (int i = 1; i <= 40; ++i) {
+            std::string c = std::to_string(i);
+            source += (i % 3 == 0 ? " - " : " + ")
+                + ("sin(" + c + "*x)*(x^2 + y*" + c + ")*exp(x/" + c + ")")
+                + " * (x + y*ln(x) - " + c + "*x*y)";
+        }
+        Expression<double> expr = parseExpression(source);
+        ThreadPool pool(4);
+        for (std::size_t cutoff : {std::size_t(1), std::size_t(16), DEFAULT_PARALLEL_CUTOFF}) {
+            std::string suffix = " (cutoff " + std::to_string(cutoff) + ")";
+            check(sameTree(parallelDerivative(expr, "x", pool, cutoff), expr.derivative("x")),
+                  "parallel: производная по x совпадает с последовательной" + suffix);
+            check(sameTree(parallelDerivative(expr, "y", pool, cutoff), expr.derivative("y")),
+                  "parallel: производная по y совпадает с последовательной" + suffix);
+            check(sameTree(parallelSubstitute(expr, "x", 2.0, pool, cutoff), expr.substitute("x", 2.0)),
+                  "parallel: подстановка x=2 совпадает с последовательной" + suffix);
+        }
+    }
+
+    // Тест 10: поток, который только освобождает узлы, возвращает их в общий пул
+    {
+        using Pool = NodePool<sizeof(Expression<double>)>;
+        std::vector<std::unique_ptr<Expression<double>>> nodes;
+        for (int i = 0; i < 300; ++i)
+            nodes.emplace_back(new Expression<double>(static_cast<double>(i)));
+        std::size_t before = Pool::sharedCount();
+        std::thread([&nodes] { nodes.clear(); }).join();
+        check(Pool::sharedCount() >= before + 300,
+              "node pool: блоки освобождающего потока возвращаются при его завершении");
+    }
+
     return 0;
 }